@@ -1,15 +1,19 @@
 #include "BasicOCR.h"
 
 // In this case the double colon means we are defining a function of the class from the header
-BasicOCR::BasicOCR(){
+BasicOCR::BasicOCR(const std::string& dataPath){
     // create the object
     ocr = new tesseract::TessBaseAPI();
     // tell the api the image will only have one character
     ocr->SetPageSegMode(tesseract::PSM_SINGLE_CHAR);
     // only allow 1-9 to be returned
     ocr->SetVariable("tessedit_char_whitelist","123456789");
-    // use the english data from the local tesdata folder
-    ocr->Init("./tessdata", "eng", tesseract::OEM_DEFAULT);
+    // use the english data from the tesdata folder, Init gives back 0 if it loaded
+    ready = ocr->Init(dataPath.c_str(), "eng", tesseract::OEM_DEFAULT)==0;
+}
+
+bool BasicOCR::ok() const{
+    return ready;
 }
 
 BasicOCR::~BasicOCR(){
@@ -24,10 +28,16 @@ void BasicOCR::process(cv::Mat& img){
 }
 
 int BasicOCR::classify(cv::Mat img){
+    // tesseract can't read anything without its language data
+    if (!ready)
+        return 0;
     // preprocess the image
     process(img);
     // read the image into the ocr object
     ocr->SetImage((uchar*)img.data, img.cols, img.rows, 1, img.cols);
-    // return the classified text as an integer
-    return atoi(ocr->GetUTF8Text());
+    // return the classified text as an integer, the text is ours to free
+    char* text = ocr->GetUTF8Text();
+    int value = text ? atoi(text) : 0;
+    delete[] text;
+    return value;
 }
\ No newline at end of file
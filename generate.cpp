@@ -0,0 +1,107 @@
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include "puzzleGenerator.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <sys/stat.h>
+
+// print how to use the program
+void usage(){
+    std::cerr<<"usage: SudokuGen <count> [--threads n] [--seed n] [--clues n] [--render directory] [--flat] [--bench] [--quiet]"<<std::endl;
+}
+
+// generates puzzles, prints them one per line as 81 characters and their difficulty and can render them to images
+// with a ground truth file beside each one for the OCR harness
+int main(int argc, char ** argv){
+    if (argc<2){
+        usage();
+        return 1;
+    }
+    int count = atoi(argv[1]);
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int seed = 0;
+    int clues = 0;
+    std::string renderDir;
+    bool distort = true, bench = false, quiet = false;
+    // read the options
+    for (int counter = 2; counter<argc; counter++){
+        if (!strcmp(argv[counter], "--threads") && counter+1<argc) threads = atoi(argv[++counter]);
+        else if (!strcmp(argv[counter], "--seed") && counter+1<argc) seed = atoi(argv[++counter]);
+        else if (!strcmp(argv[counter], "--clues") && counter+1<argc) clues = atoi(argv[++counter]);
+        else if (!strcmp(argv[counter], "--render") && counter+1<argc) renderDir = argv[++counter];
+        else if (!strcmp(argv[counter], "--flat")) distort = false;
+        else if (!strcmp(argv[counter], "--bench")) bench = true;
+        else if (!strcmp(argv[counter], "--quiet")) quiet = true;
+        else{
+            usage();
+            return 1;
+        }
+    }
+    if (count<=0){
+        usage();
+        return 1;
+    }
+    // check where the images go before spending time generating them
+    struct stat info;
+    if (!renderDir.empty() && (stat(renderDir.c_str(), &info)!=0 || !S_ISDIR(info.st_mode))){
+        std::cerr<<renderDir<<" isn't a directory"<<std::endl;
+        return 1;
+    }
+
+    // generate the puzzles and time it
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<Puzzle> puzzles = generatePuzzles(count, seed, threads, clues);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+
+    // count how many puzzles there are of each difficulty
+    int difficulties[UNSOLVABLE+1] = {0};
+    for (size_t counter = 0; counter<puzzles.size(); counter++){
+        difficulties[puzzles[counter].difficulty]++;
+        if (!quiet)
+            std::cout<<boardToString(puzzles[counter].board)<<" "<<difficultyName(puzzles[counter].difficulty)<<std::endl;
+    }
+    std::cerr<<"generated "<<count<<" puzzles on "<<threads<<" threads in "<<seconds<<"s ("<<count/seconds<<" puzzles/sec)"<<std::endl;
+    for (int difficulty = EASY; difficulty<=HARD; difficulty++)
+        std::cerr<<"  "<<difficultyName((Difficulty)difficulty)<<": "<<difficulties[difficulty]<<std::endl;
+
+    // time the solver on every puzzle
+    if (bench){
+        start = std::chrono::steady_clock::now();
+        int solved = 0;
+        for (size_t counter = 0; counter<puzzles.size(); counter++){
+            int board[9][9];
+            memcpy(board, puzzles[counter].board, sizeof(board));
+            if (solveBoard(board) && !memcmp(board, puzzles[counter].solution, sizeof(board)))
+                solved++;
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+        std::cerr<<"solved "<<solved<<"/"<<count<<" in "<<seconds<<"s ("<<count/seconds<<" solves/sec)"<<std::endl;
+    }
+
+    // render every puzzle with its ground truth beside it
+    if (!renderDir.empty()){
+        for (size_t counter = 0; counter<puzzles.size(); counter++){
+            // the distortion and noise of each image only depend on the seed and the puzzle's index too
+            std::mt19937 rng = puzzleRng(seed, counter, 1);
+            std::string path = renderDir + "/puzzle" + std::to_string(counter);
+            if (!cv::imwrite(path + ".png", renderPuzzle(puzzles[counter], rng, distort))){
+                std::cerr<<"couldn't write "<<path<<".png"<<std::endl;
+                return 1;
+            }
+            std::ofstream truth(path + ".txt");
+            truth<<boardToString(puzzles[counter].board)<<std::endl;
+            // closing flushes the file so a full disk shows up here
+            truth.close();
+            if (!truth){
+                std::cerr<<"couldn't write "<<path<<".txt"<<std::endl;
+                return 1;
+            }
+        }
+        std::cerr<<"rendered "<<count<<" puzzles to "<<renderDir<<std::endl;
+    }
+    return 0;
+}
@@ -7,8 +7,10 @@ struct line{
     cv::Point pt1, pt2;
 };
 
-// kernel used to erode and dilate our board
-cv::Mat kernel = (cv::Mat_<uchar>(3,3) << 0,1,0,1,1,1,0,1,0);
+// kernel used to erode and dilate our board(a 3x3 cross), made when needed so there is no global state
+static cv::Mat kernel(){
+    return cv::getStructuringElement(cv::MORPH_CROSS, cv::Size(3,3));
+}
 
 // check if the board is a valid board
 bool isSudoku(cv::Mat image){
@@ -54,7 +56,80 @@ void preprocessing(cv::Mat board, cv::Mat& outer){
     // invert
     cv::bitwise_not(outer, outer);
     // dilate the image
-    dilate(outer, outer, kernel);
+    dilate(outer, outer, kernel());
+}
+
+// preprocess the board using the intermediates already computed for this frame
+void preprocessing(FrameCache& cache, cv::Mat& outer){
+    // make a black and white image where the dark lines of the board are white(already inverted)
+    binarize(cache.blurred, localMean(cache, 5), 2, outer);
+    // dilate the image
+    dilate(outer, outer, kernel());
+}
+
+// blur the frame and build its integral image once so every threshold stage can share them
+void buildFrameCache(cv::Mat board, FrameCache& cache){
+    // use a Gaussian blur to make it easier to idenitfy the biggest blob
+    cv::GaussianBlur(board, cache.blurred, cv::Size(11,11), 0);
+    // the integral image lets sampleMean get the sum of any rectangle around a warped point with 4 lookups
+    cv::integral(cache.blurred, cache.integral, CV_64F);
+}
+
+// get the mean of the blockSize x blockSize neighbourhood around every pixel
+const cv::Mat& localMean(FrameCache& cache, int blockSize){
+    // the same vectorised box filter adaptiveThreshold uses, so the shared path gives the same mean as the legacy one
+    cv::boxFilter(cache.blurred, cache.mean, -1, cv::Size(blockSize, blockSize), cv::Point(-1,-1), true, cv::BORDER_REPLICATE|cv::BORDER_ISOLATED);
+    return cache.mean;
+}
+
+// set pixels that are darker than their local mean by more than offset to white and everything else to black
+void binarize(cv::Mat src, cv::Mat mean, int offset, cv::Mat& dest){
+    dest.create(src.size(), CV_8UC1);
+    for (int y = 0; y<src.rows; y++){
+        const uchar* in = src.ptr(y);
+        const uchar* threshold = mean.ptr(y);
+        uchar* out = dest.ptr(y);
+        for (int x = 0; x<src.cols; x++)
+            out[x] = (in[x] <= threshold[x]-offset) ? 255 : 0;
+    }
+}
+
+// get the mean of the blockSize x blockSize block of the frame around where each pixel of a warped image comes from
+// inverse takes a point of the warped image back to the frame, so only the pixels of the warped image are worked out
+void sampleMean(FrameCache& cache, cv::Mat inverse, cv::Size size, int blockSize, cv::Mat& mean){
+    int rows = cache.blurred.rows, cols = cache.blurred.cols, radius = blockSize/2;
+    const double* h = inverse.ptr<double>();
+    mean.create(size, CV_8UC1);
+    for (int y = 0; y<size.height; y++){
+        uchar* out = mean.ptr(y);
+        for (int x = 0; x<size.width; x++){
+            // find the nearest pixel of the frame, staying inside the frame like a replicated border
+            double w = h[6]*x + h[7]*y + h[8];
+            int frameX = std::min(std::max(cvRound((h[0]*x + h[1]*y + h[2])/w), 0), cols-1);
+            int frameY = std::min(std::max(cvRound((h[3]*x + h[4]*y + h[5])/w), 0), rows-1);
+            // clamp the block to the frame so the edges use the pixels that exist
+            int top = std::max(frameY-radius, 0), bottom = std::min(frameY+radius+1, rows);
+            int left = std::max(frameX-radius, 0), right = std::min(frameX+radius+1, cols);
+            const double* topRow = cache.integral.ptr<double>(top);
+            const double* bottomRow = cache.integral.ptr<double>(bottom);
+            double sum = bottomRow[right] - bottomRow[left] - topRow[right] + topRow[left];
+            out[x] = cv::saturate_cast<uchar>(sum/((bottom-top)*(right-left)));
+        }
+    }
+}
+
+// threshold the undistorted board against the frame's local mean sampled where each of its pixels came from
+void thresholdUndistorted(FrameCache& cache, cv::Mat undistorted, cv::Mat transform, cv::Mat& binary){
+    // the warp keeps roughly the same scale as the board in the frame so the block size carries over
+    cv::Mat mean;
+    sampleMean(cache, transform.inv(), undistorted.size(), 101, mean);
+    binarize(undistorted, mean, 1, binary);
+}
+
+// threshold the undistorted board using the inverse transform kept with the warp tables
+void thresholdUndistorted(FrameCache& cache, WarpCache& warp, cv::Mat undistorted, cv::Mat& binary){
+    sampleMean(cache, warp.inverse, undistorted.size(), 101, warp.mean);
+    binarize(undistorted, warp.mean, 1, binary);
 }
 
 // find the largest blob in the image
@@ -90,11 +165,62 @@ int32_t biggestBlob(cv::Mat& outer){
                cv::floodFill(outer, cv::Point(counter2, counter), CV_RGB(0,0,0));
     
     // undo the dilate step in the preprocessing so our image is clear to extract numbers
-    cv::erode(outer, outer, kernel);
+    cv::erode(outer, outer, kernel());
     // return the max area
     return area;
 }
 
+// find every blob that is shaped like a grid in one labeling pass, giving back the box around each and a mask of it
+void findGridBlobs(cv::Mat outer, int minSide, std::vector<cv::Rect>& boxes, std::vector<cv::Mat>& masks){
+    cv::Mat labels, stats, centroids;
+    int count = cv::connectedComponentsWithStats(outer, labels, stats, centroids, 8, CV_32S);
+    // label 0 is the background
+    for (int label = 1; label<count; label++){
+        cv::Rect box(stats.at<int>(label, cv::CC_STAT_LEFT), stats.at<int>(label, cv::CC_STAT_TOP), stats.at<int>(label, cv::CC_STAT_WIDTH), stats.at<int>(label, cv::CC_STAT_HEIGHT));
+        int area = stats.at<int>(label, cv::CC_STAT_AREA);
+        // a board is big, roughly square(even at an angle) and mostly empty space between its lines
+        if (box.width<minSide || box.height<minSide)
+            continue;
+        if (box.width>box.height*2 || box.height>box.width*2)
+            continue;
+        if (area>box.area()/2)
+            continue;
+
+        // cut out just this blob
+        cv::Mat mask = (labels(box) == label);
+        // undo the dilate step in the preprocessing like biggestBlob does
+        cv::erode(mask, mask, kernel());
+        boxes.push_back(box);
+        masks.push_back(mask);
+    }
+}
+
+bool hasGridLines(cv::Mat binary){
+    if (binary.empty())
+        return false;
+    // how much of every row and column is white(the lines are white in the black and white board)
+    cv::Mat rows, cols;
+    cv::reduce(binary, rows, 1, cv::REDUCE_SUM, CV_32S);
+    cv::reduce(binary, cols, 0, cv::REDUCE_SUM, CV_32S);
+
+    int found = 0;
+    for (int line = 1; line<9; line++){
+        // look for a line within a quarter of a cell of where each inner line of the grid should be
+        int row = line*binary.rows/9, col = line*binary.cols/9;
+        int rowBand = std::max(1, binary.rows/36), colBand = std::max(1, binary.cols/36);
+        int bestRow = 0, bestCol = 0;
+        for (int offset = -rowBand; offset<=rowBand; offset++)
+            bestRow = std::max(bestRow, rows.at<int>(std::min(std::max(row+offset, 0), binary.rows-1), 0));
+        for (int offset = -colBand; offset<=colBand; offset++)
+            bestCol = std::max(bestCol, cols.at<int>(0, std::min(std::max(col+offset, 0), binary.cols-1)));
+        // a line has to be white across at least half the board, numbers and noise never get that far
+        if (bestRow>=255*binary.cols/2) found++;
+        if (bestCol>=255*binary.rows/2) found++;
+    }
+    // let a few of the thin lines be broken up by glare or a bad threshold
+    return found>=12;
+}
+
 struct line calcLine(float rho, float theta, cv::Mat board){
     struct line line1;
     // if the line is approx horizontal then we set our points at the extreme left and right
@@ -203,11 +329,12 @@ void getIntersectionValues(double& a, double& b, double& c, struct line edge){
     c = a*edge.pt1.x + b*edge.pt1.y;
 }
 
-cv::Mat undistortImage(cv::Mat original, cv::Vec2f& topEdge, cv::Vec2f& bottomEdge, cv::Vec2f& leftEdge, cv::Vec2f& rightEdge){
+// get the corners of the board(top left, top right, bottom right, bottom left) from its edges
+void getBoardCorners(cv::Size size, cv::Vec2f& topEdge, cv::Vec2f& bottomEdge, cv::Vec2f& leftEdge, cv::Vec2f& rightEdge, cv::Point2f corners[4]){
     // define the outer board lines
     struct line left, right, top, bottom;
-    int width = original.size().width;
-    int height = original.size().height;
+    int width = size.width;
+    int height = size.height;
 
     // find two points on a line(for the grid) which will later be used to undistort the image
 
@@ -265,10 +392,17 @@ cv::Mat undistortImage(cv::Mat original, cv::Vec2f& topEdge, cv::Vec2f& bottomEd
     double differenceToBottomRight = rightA*bottomB - rightB*bottomA;
 
     // calculate the points of the grid
-    cv::Point2f topLeft = cv::Point2f((topB*leftC - leftB*topC)/differenceToTopLeft, (leftA*topC - topA*leftC)/differenceToTopLeft);
-    cv::Point2f topRight = cv::Point2f((topB*rightC-rightB*topC)/differenceToTopRight, (rightA*topC-topA*rightC)/differenceToTopRight);
-    cv::Point2f bottomLeft = cv::Point2f((bottomB*leftC-leftB*bottomC)/differenceToBottomLeft, (leftA*bottomC-bottomA*leftC)/differenceToBottomLeft);
-    cv::Point2f bottomRight = cv::Point2f((bottomB*rightC-rightB*bottomC)/differenceToBottomRight, (rightA*bottomC-bottomA*rightC)/differenceToBottomRight);
+    corners[0] = cv::Point2f((topB*leftC - leftB*topC)/differenceToTopLeft, (leftA*topC - topA*leftC)/differenceToTopLeft);
+    corners[1] = cv::Point2f((topB*rightC-rightB*topC)/differenceToTopRight, (rightA*topC-topA*rightC)/differenceToTopRight);
+    corners[3] = cv::Point2f((bottomB*leftC-leftB*bottomC)/differenceToBottomLeft, (leftA*bottomC-bottomA*leftC)/differenceToBottomLeft);
+    corners[2] = cv::Point2f((bottomB*rightC-rightB*bottomC)/differenceToBottomRight, (rightA*bottomC-bottomA*rightC)/differenceToBottomRight);
+}
+
+cv::Mat undistortImage(cv::Mat original, const cv::Point2f corners[4], cv::Mat* transform){
+    const cv::Point2f& topLeft = corners[0];
+    const cv::Point2f& topRight = corners[1];
+    const cv::Point2f& bottomRight = corners[2];
+    const cv::Point2f& bottomLeft = corners[3];
 
     // find the longest side length to know what size to crop the image to
     int maxLength = sqrt((double)std::max({(bottomLeft.x-bottomRight.x)*(bottomLeft.x-bottomRight.x) + (bottomLeft.y-bottomRight.y)*(bottomLeft.y-bottomRight.y),
@@ -288,11 +422,55 @@ cv::Mat undistortImage(cv::Mat original, cv::Vec2f& topEdge, cv::Vec2f& bottomEd
     destGrid[3] = cv::Point2f(0, maxLength-1);
     // declare an undistorted image
     cv::Mat undistorted = cv::Mat(cv::Size(maxLength, maxLength), CV_8UC3);
+    cv::Mat perspective = cv::getPerspectiveTransform(srcGrid, destGrid);
     // undistort the image with all the information we have gathered
-    cv::warpPerspective(original, undistorted, cv::getPerspectiveTransform(srcGrid, destGrid), cv::Size(maxLength, maxLength));
+    cv::warpPerspective(original, undistorted, perspective, cv::Size(maxLength, maxLength));
+    // give the transform back to the caller if they want to warp anything else the same way
+    if (transform)
+        *transform = perspective;
     return undistorted;
 }
 
+void undistortImage(cv::Mat original, const cv::Point2f corners[4], WarpCache& cache, cv::Mat& dest, int size){
+    // check if the board has moved since the tables were built
+    bool moved = cache.size!=size;
+    for (int counter = 0; counter<4 && !moved; counter++)
+        moved = fabs(corners[counter].x-cache.corners[counter].x)>CORNER_TOLERANCE || fabs(corners[counter].y-cache.corners[counter].y)>CORNER_TOLERANCE;
+
+    // rebuild the tables that say where each pixel of the board comes from in the frame
+    if (moved){
+        cv::Point2f srcGrid[4], destGrid[4];
+        for (int counter = 0; counter<4; counter++){
+            srcGrid[counter] = corners[counter];
+            cache.corners[counter] = corners[counter];
+        }
+        destGrid[0] = cv::Point2f(0,0);
+        destGrid[1] = cv::Point2f(size-1, 0);
+        destGrid[2] = cv::Point2f(size-1, size-1);
+        destGrid[3] = cv::Point2f(0, size-1);
+        // the inverse transform takes a point on the board back to the frame
+        cache.inverse = cv::getPerspectiveTransform(destGrid, srcGrid);
+        const double* h = cache.inverse.ptr<double>();
+
+        cv::Mat mapX(size, size, CV_32FC1), mapY(size, size, CV_32FC1);
+        for (int y = 0; y<size; y++){
+            float* rowX = mapX.ptr<float>(y);
+            float* rowY = mapY.ptr<float>(y);
+            for (int x = 0; x<size; x++){
+                double w = h[6]*x + h[7]*y + h[8];
+                rowX[x] = (h[0]*x + h[1]*y + h[2])/w;
+                rowY[x] = (h[3]*x + h[4]*y + h[5])/w;
+            }
+        }
+        // fixed point tables are faster to remap with than floating point ones
+        cv::convertMaps(mapX, mapY, cache.mapXY, cache.mapInterp, CV_16SC2);
+        cache.size = size;
+    }
+
+    // bilinear remap into the caller's buffer, which is only allocated the first time
+    cv::remap(original, dest, cache.mapXY, cache.mapInterp, cv::INTER_LINEAR);
+}
+
 // find lines in the image
 std::vector<cv::Vec2f> findLines(cv::Mat& box, cv::Vec2f& topEdge, cv::Vec2f& bottomEdge, cv::Vec2f& leftEdge, cv::Vec2f& rightEdge){
     std::vector<cv::Vec2f> lines;
@@ -309,6 +487,77 @@ std::vector<cv::Vec2f> findLines(cv::Mat& box, cv::Vec2f& topEdge, cv::Vec2f& bo
     return lines;
 }
 
+// try to fit a quadrilateral directly to the outline of the biggest blob and refine its corners to sub pixel accuracy
+bool findQuad(cv::Mat& box, cv::Mat gray, cv::Point2f corners[4]){
+    // only keep the biggest blob(the other blobs were flood filled with darker values)
+    cv::Mat blob;
+    cv::threshold(box, blob, 127, 255, cv::THRESH_BINARY);
+    std::vector<std::vector<cv::Point>> contours;
+    cv::findContours(blob, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+    // find the contour with the largest area
+    double largestArea = 0;
+    int largest = -1;
+    for (size_t counter = 0; counter<contours.size(); counter++){
+        double area = cv::contourArea(contours[counter]);
+        if (area>largestArea){
+            largestArea = area;
+            largest = counter;
+        }
+    }
+    // if the board takes up too little of the image then it's probably not the board
+    if (largest == -1 || largestArea<box.total()/20)
+        return false;
+
+    // simplify the outline, a board should simplify down to 4 corners
+    std::vector<cv::Point> quad;
+    cv::approxPolyDP(contours[largest], quad, 0.02*cv::arcLength(contours[largest], true), true);
+    if (quad.size()!=4 || !cv::isContourConvex(quad))
+        return false;
+
+    // order the corners as top left, top right, bottom right, bottom left
+    // the top left has the smallest x+y, the bottom right the largest, the top right the largest x-y and the bottom left the smallest
+    int topLeft = 0, topRight = 0, bottomRight = 0, bottomLeft = 0;
+    for (int counter = 1; counter<4; counter++){
+        if (quad[counter].x+quad[counter].y < quad[topLeft].x+quad[topLeft].y) topLeft = counter;
+        if (quad[counter].x+quad[counter].y > quad[bottomRight].x+quad[bottomRight].y) bottomRight = counter;
+        if (quad[counter].x-quad[counter].y > quad[topRight].x-quad[topRight].y) topRight = counter;
+        if (quad[counter].x-quad[counter].y < quad[bottomLeft].x-quad[bottomLeft].y) bottomLeft = counter;
+    }
+    // if two corners were picked as the same point then the shape is too rotated to trust the ordering
+    if (topLeft==topRight || topLeft==bottomLeft || bottomRight==topRight || bottomRight==bottomLeft || topRight==bottomLeft)
+        return false;
+
+    std::vector<cv::Point2f> refined = {cv::Point2f(quad[topLeft]), cv::Point2f(quad[topRight]), cv::Point2f(quad[bottomRight]), cv::Point2f(quad[bottomLeft])};
+    // move the corners to the exact sub pixel location of the corner in the original image
+    cv::cornerSubPix(gray, refined, cv::Size(5,5), cv::Size(-1,-1), cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 20, 0.03));
+    for (int counter = 0; counter<4; counter++)
+        corners[counter] = refined[counter];
+    return true;
+}
+
+// perceptual hash of a frame, each bit says if a pixel of a tiny 9x8 gray version is brighter than the one to its right
+uint64_t frameHash(cv::Mat frame){
+    // shrinking first means the color conversion only has to be done on 72 pixels
+    cv::Mat small;
+    cv::resize(frame, small, cv::Size(9,8), 0, 0, cv::INTER_AREA);
+    if (small.channels()==3)
+        cv::cvtColor(small, small, cv::COLOR_BGR2GRAY);
+
+    uint64_t hash = 0;
+    for (int y = 0; y<8; y++){
+        const uchar* row = small.ptr(y);
+        for (int x = 0; x<8; x++)
+            hash = (hash<<1) | (row[x]>row[x+1]);
+    }
+    return hash;
+}
+
+// how many bits are different between two hashes
+int hashDistance(uint64_t first, uint64_t second){
+    return __builtin_popcountll(first^second);
+}
+
 // convert between image types of number of rows and form etc.
 void convertToCV8UC1(cv::Mat& mat){
     cv::cvtColor(mat,mat, CV_BGR2GRAY);
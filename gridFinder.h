@@ -8,14 +8,66 @@
 #include <opencv2/imgproc.hpp>
 #include <opencv2/highgui.hpp>
 #include <vector>
+#include <cstdint>
 #include <iostream>
 
+// side length of the canonical board the image can be warped to so every cell is 28 pixels
+#define BOARD_SIZE 252
+// how far(in pixels) the corners can move before the warp tables have to be rebuilt
+#define CORNER_TOLERANCE 0.25f
+
+// intermediates of a single frame that are shared by every thresholding stage so they are only computed once
+struct FrameCache{
+    // the frame after a Gaussian blur
+    cv::Mat blurred;
+    // integral image of the blurred frame which gives the sum of any rectangle in constant time
+    cv::Mat integral;
+    // local mean of the blurred frame used to find the board's lines
+    cv::Mat mean;
+};
+
+// warp tables and buffers kept between frames so a board that hasn't moved is warped without recomputing or allocating anything
+struct WarpCache{
+    // the corners the tables were built for
+    cv::Point2f corners[4];
+    // side length of the warped board, 0 until the tables are built
+    int size = 0;
+    // fixed point remap tables that map every pixel of the warped board back into the frame
+    cv::Mat mapXY, mapInterp;
+    // the transform the tables were built from, taking a point on the board back to the frame
+    cv::Mat inverse;
+    // the warped local mean used to threshold the warped board
+    cv::Mat mean;
+    // the frame's blurred copy, integral image and black and white lines, reused while the frames keep the same size
+    FrameCache frame;
+    cv::Mat outer;
+};
+
 // used for debugging and drawing a line
 void drawLine(cv::Vec2f line, cv::Mat &img, cv::Scalar rgb);
 // cleans up the object
 void preprocessing(cv::Mat board, cv::Mat& outer);
+// cleans up the object using the intermediates already computed for the frame
+void preprocessing(FrameCache& cache, cv::Mat& outer);
+// blurs the frame and builds the integral image the board's threshold samples from
+void buildFrameCache(cv::Mat board, FrameCache& cache);
+// gets the mean of the blockSize x blockSize block around every pixel of the frame
+const cv::Mat& localMean(FrameCache& cache, int blockSize);
+// sets the pixels darker than their local mean by more than the offset to white and the rest to black
+void binarize(cv::Mat src, cv::Mat mean, int offset, cv::Mat& dest);
+// gets the frame's local mean at the point each pixel of a size sized warped image comes from
+void sampleMean(FrameCache& cache, cv::Mat inverse, cv::Size size, int blockSize, cv::Mat& mean);
+// thresholds the undistorted board using the frame's local mean sampled through the inverse of the transform
+void thresholdUndistorted(FrameCache& cache, cv::Mat undistorted, cv::Mat transform, cv::Mat& binary);
+// thresholds the undistorted board using the frame's local mean sampled through the warp tables' transform
+void thresholdUndistorted(FrameCache& cache, WarpCache& warp, cv::Mat undistorted, cv::Mat& binary);
 // Finds the biggest "blob"(the board) in the image
 int biggestBlob(cv::Mat& outer);
+// finds every grid shaped blob with sides of at least minSide, giving the box around each and its mask
+void findGridBlobs(cv::Mat outer, int minSide, std::vector<cv::Rect>& boxes, std::vector<cv::Mat>& masks);
+// check the black and white warped board has the inner lines of a 9x9 grid where they should be
+// so frames, boxed ads and tables that passed findGridBlobs' shape tests aren't read as boards
+bool hasGridLines(cv::Mat binary);
 // calculates the a line given the rho, theta and the board
 struct line calcLine(float rho, float theta, cv::Mat board);
 // merges lines that are relatively similar
@@ -24,14 +76,24 @@ void mergeCloseLines(cv::Mat board, std::vector<cv::Vec2f>* lines);
 void findExtremeLines(cv::Mat& board, std::vector<cv::Vec2f>* lines, cv::Vec2f& topEdge, cv::Vec2f& bottomEdge, cv::Vec2f& leftEdge, cv::Vec2f& rightEdge);
 // gets the intersection of various values from an edge
 void getIntersectionValues(double& a, double& b, double& c, struct line edge);
-// undistort the image given the corners of the board
-cv::Mat undistortImage(cv::Mat original, cv::Vec2f& topEdge, cv::Vec2f& bottomEdge, cv::Vec2f& leftEdge, cv::Vec2f& rightEdge);
+// gets the corners of the board(top left, top right, bottom right, bottom left) from the edges of the board
+void getBoardCorners(cv::Size size, cv::Vec2f& topEdge, cv::Vec2f& bottomEdge, cv::Vec2f& leftEdge, cv::Vec2f& rightEdge, cv::Point2f corners[4]);
+// undistort the image given the corners of the board, optionally giving back the transform used
+cv::Mat undistortImage(cv::Mat original, const cv::Point2f corners[4], cv::Mat* transform = nullptr);
+// undistort the image into a size x size board in dest, reusing the remap tables while the corners don't move
+void undistortImage(cv::Mat original, const cv::Point2f corners[4], WarpCache& cache, cv::Mat& dest, int size = BOARD_SIZE);
 // get the lines of the sudoku board
 std::vector<cv::Vec2f> findLines(cv::Mat& box, cv::Vec2f& topEdge, cv::Vec2f& bottomEdge, cv::Vec2f& leftEdge, cv::Vec2f& rightEdge);
+// fits a quadrilateral to the biggest blob and refines the corners(top left, top right, bottom right, bottom left) on the gray image
+bool findQuad(cv::Mat& box, cv::Mat gray, cv::Point2f corners[4]);
 // check if the board is an actual sudoku board
 bool isSudoku(cv::Mat image);
 // contour the cell to crop to the number in the cell and reduce noise
 cv::Rect contour(cv::Mat img, int cellSize);
+// perceptual hash of a frame used to tell if two frames look the same
+uint64_t frameHash(cv::Mat frame);
+// how many bits are different between two frame hashes
+int hashDistance(uint64_t first, uint64_t second);
 // convert to CV_8UC1 image type for compatibility
 void convertToCV8UC1(cv::Mat& mat);
 
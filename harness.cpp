@@ -0,0 +1,199 @@
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include "pipeline.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+// an image of the corpus and the numbers that are actually on its board
+struct Sample{
+    std::string image;
+    int truth[9][9];
+};
+
+// the results of running one config over the whole corpus
+struct Report{
+    PipelineConfig config;
+    int images = 0, found = 0;
+    // how many cells with each true value(rows) were read as each value(columns), 0 is an empty cell
+    long long confusion[10][10] = {};
+    // time spent in every stage and in total in milliseconds
+    StageTimes times;
+    double decode = 0, total = 0;
+};
+
+// read the 81 character ground truth file, '0' or '.' is an empty cell
+bool readTruth(const std::string& path, int truth[9][9]){
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    int cells = 0;
+    for (size_t counter = 0; counter<line.size() && cells<81; counter++){
+        char c = line[counter];
+        if (c=='.') c = '0';
+        if (c<'0' || c>'9') continue;
+        truth[cells/9][cells%9] = c-'0';
+        cells++;
+    }
+    return cells==81;
+}
+
+// find every image in the directory that has a ground truth file beside it
+std::vector<Sample> loadCorpus(const std::string& directory){
+    std::vector<cv::String> truths;
+    cv::glob(directory + "/*.txt", truths, false);
+    std::vector<Sample> samples;
+    const char* extensions[] = {".png", ".jpg", ".jpeg"};
+    for (size_t counter = 0; counter<truths.size(); counter++){
+        Sample sample;
+        if (!readTruth(truths[counter], sample.truth)){
+            std::cerr<<"skipping "<<truths[counter]<<": it doesn't have 81 cells"<<std::endl;
+            continue;
+        }
+        // the image has the same name as the ground truth file
+        std::string stem = std::string(truths[counter]).substr(0, truths[counter].size()-4);
+        for (const char* extension : extensions){
+            std::ifstream image(stem + extension);
+            if (image.good()){
+                sample.image = stem + extension;
+                break;
+            }
+        }
+        if (sample.image.empty())
+            std::cerr<<"skipping "<<truths[counter]<<": no image found"<<std::endl;
+        else
+            samples.push_back(sample);
+    }
+    return samples;
+}
+
+// run the whole pipeline with the config over one sample and add the results to the report
+void runSample(const Sample& sample, BasicOCR& ocr, Report& report){
+    int64 start = cv::getTickCount();
+    // read the image
+    cv::Mat img = cv::imread(sample.image, cv::IMREAD_GRAYSCALE);
+    report.decode += (cv::getTickCount()-start)*1000.0/cv::getTickFrequency();
+    report.images++;
+
+    // find the board and read the cells, a board that isn't found is read as all empty cells
+    int grid[9][9] = {};
+    cv::Mat board, binary;
+    if (!img.empty() && getSudokuGrid(img, board, &binary, nullptr, report.config, &report.times)){
+        report.found++;
+        readCells(binary, ocr, grid, &report.times);
+    }
+
+    for (int cell = 0; cell<81; cell++){
+        int read = grid[cell/9][cell%9];
+        // anything the ocr returns that isn't a digit counts as unread
+        if (read<0 || read>9) read = 0;
+        report.confusion[sample.truth[cell/9][cell%9]][read]++;
+    }
+    report.total += (cv::getTickCount()-start)*1000.0/cv::getTickFrequency();
+}
+
+// run every config over every sample, taking turns on each image so no config is timed with colder caches than the others
+void runConfigs(const std::vector<Sample>& samples, std::vector<Report>& reports, BasicOCR& ocr){
+    // an untimed pass over the first image so first use costs(loading libraries, tesseract's first read) aren't counted
+    for (size_t config = 0; config<reports.size(); config++){
+        Report warmup;
+        warmup.config = reports[config].config;
+        runSample(samples[0], ocr, warmup);
+    }
+
+    for (size_t counter = 0; counter<samples.size(); counter++)
+        for (size_t turn = 0; turn<reports.size(); turn++){
+            // flip the order every image so each config goes first as often as it goes second
+            size_t config = counter%2==0 ? turn : reports.size()-1-turn;
+            runSample(samples[counter], ocr, reports[config]);
+        }
+}
+
+// print the accuracy, confusion matrix and timings of a report
+void printReport(const Report& report){
+    long long correct = 0, cells = 0, filledCorrect = 0, filled = 0;
+    for (int truth = 0; truth<10; truth++)
+        for (int read = 0; read<10; read++){
+            cells += report.confusion[truth][read];
+            if (truth==read) correct += report.confusion[truth][read];
+            if (truth!=0){
+                filled += report.confusion[truth][read];
+                if (truth==read) filledCorrect += report.confusion[truth][read];
+            }
+        }
+
+    printf("config %s\n", configName(report.config).c_str());
+    printf("  boards found:   %d/%d\n", report.found, report.images);
+    printf("  cell accuracy:  %.2f%% (%lld/%lld)\n", cells ? 100.0*correct/cells : 0.0, correct, cells);
+    printf("  digit accuracy: %.2f%% (%lld/%lld)\n", filled ? 100.0*filledCorrect/filled : 0.0, filledCorrect, filled);
+
+    // rows are the true value and columns what was read
+    printf("  confusion (rows truth, columns read, 0 is empty)\n       ");
+    for (int read = 0; read<10; read++)
+        printf("%7d", read);
+    printf("\n");
+    for (int truth = 0; truth<10; truth++){
+        printf("  %5d", truth);
+        for (int read = 0; read<10; read++)
+            printf("%7lld", report.confusion[truth][read]);
+        printf("\n");
+    }
+
+    // average time of each stage per image
+    double images = report.images ? report.images : 1;
+    const StageTimes& times = report.times;
+    printf("  mean ms/image: decode %.2f  preprocess %.2f  blob %.2f  corners %.2f  warp %.2f  threshold %.2f  cells %.2f  ocr %.2f\n",
+        report.decode/images, times.preprocess/images, times.blob/images, times.corners/images, times.warp/images, times.threshold/images, times.cells/images, times.ocr/images);
+    printf("  total %.1f ms, %.2f images/sec\n", report.total, report.total>0 ? report.images*1000.0/report.total : 0.0);
+}
+
+// runs the pipeline over a directory of images with 81 character ground truth files beside them(like the ones SudokuGen renders)
+// and reports accuracy and speed, for one config or two to compare
+int main(int argc, char ** argv){
+    if (argc<2 || argc>4){
+        std::cerr<<"usage: OCRHarness <directory> [config] [config]"<<std::endl;
+        std::cerr<<"  a config is comma separated options: quad|hough, shared|legacy, fixed|natural"<<std::endl;
+        return 1;
+    }
+
+    // read the configs before the corpus so a typo fails straight away
+    std::vector<Report> reports(argc<3 ? 1 : argc-2);
+    for (int counter = 2; counter<argc; counter++)
+        if (!parseConfig(argv[counter], reports[counter-2].config)){
+            std::cerr<<"unknown option in config "<<argv[counter]<<std::endl;
+            std::cerr<<"  a config is comma separated options: quad|hough, shared|legacy, fixed|natural"<<std::endl;
+            return 1;
+        }
+
+    std::vector<Sample> samples = loadCorpus(argv[1]);
+    if (samples.empty()){
+        std::cerr<<"no labeled images found in "<<argv[1]<<std::endl;
+        return 1;
+    }
+
+    // the ocr is only set up once since loading the language data is slow
+    BasicOCR ocr;
+    if (!ocr.ok()){
+        std::cerr<<"couldn't load the tesseract language data"<<std::endl;
+        return 1;
+    }
+    runConfigs(samples, reports, ocr);
+
+    for (size_t counter = 0; counter<reports.size(); counter++)
+        printReport(reports[counter]);
+
+    // show the trade off between the two configs
+    if (reports.size()==2){
+        long long correct[2] = {0, 0}, cells = 0;
+        for (int report = 0; report<2; report++)
+            for (int value = 0; value<10; value++)
+                correct[report] += reports[report].confusion[value][value];
+        for (int truth = 0; truth<10; truth++)
+            for (int read = 0; read<10; read++)
+                cells += reports[0].confusion[truth][read];
+        printf("comparison %s vs %s\n", configName(reports[0].config).c_str(), configName(reports[1].config).c_str());
+        printf("  cell accuracy change: %+.2f%%\n", cells ? 100.0*(correct[1]-correct[0])/cells : 0.0);
+        printf("  speedup: %.2fx\n", reports[1].total>0 ? reports[0].total/reports[1].total : 0.0);
+    }
+    return 0;
+}
@@ -6,17 +6,20 @@
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
+#include <string>
 
 // C++ classes are defined in the header and have constructors like Java but also have destructors as
 // C++ doesn't have a garbage collector like Java
 class BasicOCR{
     // public methods
     public:
-        // Constructor
-        BasicOCR();
+        // Constructor, dataPath is the folder with the tesseract language data
+        BasicOCR(const std::string& dataPath = "./tessdata");
         // Destructor(Java doesn't have this)
         ~BasicOCR();
-        // classify the image
+        // check if the language data loaded, nothing can be read if it didn't
+        bool ok() const;
+        // classify the image, 0 if it can't be read
         int classify(cv::Mat img);
 
     private:
@@ -24,6 +27,8 @@ class BasicOCR{
         void process(cv::Mat& img);
         // api for Optical Character Recognition
         tesseract::TessBaseAPI* ocr;
+        // if Init found the language data
+        bool ready;
 
 };
 
@@ -0,0 +1,112 @@
+// the library's API, everything a program needs to go from an image, a page or a video to solved boards
+// all the buffers belong to the caller and nothing is kept between calls except what the caller passes back in
+// the stages behind it(gridFinder.h and pipeline.h) are private to the library
+#ifndef SUDOKU_OCR_H
+#define SUDOKU_OCR_H
+
+#include <opencv2/core.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BasicOCR.h"
+
+// the warp tables kept between frames, only the library knows what is in them
+struct WarpCache;
+
+namespace sudokuocr{
+
+// settings for the stages of the pipeline so different setups can be compared against each other
+struct Options{
+    // fit the outline of the board as a quad before falling back to hough lines
+    bool quadFit = true;
+    // threshold using the local mean shared between stages instead of a separate adaptive threshold per stage
+    // off until OCRHarness shows it beats the legacy threshold on the fixed size board
+    bool sharedThreshold = false;
+    // warp the board to a fixed size instead of the size it happens to be in the image
+    bool fixedSize = true;
+};
+
+// keeps the frame buffers and warp tables between the frames of a video so a frame allocates nothing new
+// and a still board isn't rewarped from scratch
+// use one per video, it can't be copied
+class Tracker{
+    public:
+        Tracker();
+        ~Tracker();
+
+    private:
+        Tracker(const Tracker&);
+        Tracker& operator=(const Tracker&);
+        std::unique_ptr<WarpCache> warp;
+        friend bool detectGrid(cv::Mat gray, cv::Mat& board, cv::Mat& binary, Tracker& tracker, const Options& options);
+};
+
+// one ocr per thread for reading the boards of a page in parallel since tesseract can't be shared between threads
+// keep it between pages so the language data is only loaded once, it can't be copied
+class OCRPool{
+    public:
+        // loads size ocrs from the language data in the dataPath folder
+        OCRPool(int size, const std::string& dataPath = "./tessdata");
+        // check if every ocr loaded its language data
+        bool ok() const;
+        // how many ocrs(and so threads) there are
+        int size() const;
+        // the ocr for a thread
+        BasicOCR& operator[](int index);
+
+    private:
+        OCRPool(const OCRPool&);
+        OCRPool& operator=(const OCRPool&);
+        std::vector<std::unique_ptr<BasicOCR>> ocrs;
+};
+
+// a board found on a page with several boards on it
+struct Board{
+    // where the board's blob is on the page
+    cv::Rect area;
+    // the warped board and the black and white version of it
+    cv::Mat board, binary;
+    // the numbers read from the board, 0 for an empty cell
+    int grid[9][9];
+    // the solved board if solved is true
+    int solution[9][9];
+    bool solved = false;
+};
+
+// a board found in a video along with the frame it first appeared in
+struct VideoBoard{
+    int frame;
+    int grid[9][9];
+};
+
+// what was found in a video file
+struct VideoScan{
+    // how many frames were read and how many were different enough from the last one to look for a board in
+    int frames = 0, processed = 0;
+    // every distinct board in the order it first appeared
+    std::vector<VideoBoard> boards;
+};
+
+// turns a color frame into the gray image the rest of the library works on
+void toGray(cv::Mat frame, cv::Mat& gray);
+// finds the board in the gray image and warps it into board and its black and white version into binary
+// keep the tracker between the frames of a video so the warp tables are only rebuilt when the board moves
+bool detectGrid(cv::Mat gray, cv::Mat& board, cv::Mat& binary, Tracker& tracker, const Options& options = Options());
+// cuts the number out of each of the 81 cells of the black and white board(left to right, top to bottom)
+// a cell without a number is left empty
+void extractCells(cv::Mat binary, std::vector<cv::Mat>& cells);
+// reads the number in each cell into grid, 0 for an empty cell
+void classifyCells(const std::vector<cv::Mat>& cells, BasicOCR& ocr, int grid[9][9]);
+// solves the board in place, returns false if it can't be solved
+bool solve(int board[9][9]);
+// finds, reads and solves every board on the gray page with the reading split over a thread per ocr in the pool
+// returns false if the pool's language data couldn't be loaded
+bool solvePage(cv::Mat page, std::vector<Board>& boards, OCRPool& pool, const Options& options = Options());
+// reads every frame of a video file, only looking for a board in frames whose hash is more than maxDistance bits
+// from the last frame looked at, and gives back every distinct board once with the most numbers it was read with
+// returns false if the file can't be opened
+bool scanVideo(const std::string& path, BasicOCR& ocr, VideoScan& scan, int maxDistance = 4, const Options& options = Options());
+
+}
+
+#endif
@@ -1,8 +1,10 @@
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
 #include <opencv2/opencv.hpp>
-#include "gridFinder.h"
-#include "BasicOCR.h"
+#include "sudokuocr.h"
+#include <cstring>
+#include <iostream>
+#include <thread>
 #include "sudoku.h"
 #include <math.h>
 
@@ -10,33 +12,6 @@
 // this allows for changes to the variable in the function to be made to the variable in the scope where
 // the function is called. This is useful when more than 1 value needs to be returned
 
-// gets the sudoku cropped image grid
-bool getSudokuGrid(cv::Mat& sudoku){
-    // C++ has namespaces so you can have multiple functions with the same name but in different name spaces
-    // the double colon means a function or value in said namespace
-    
-    // creates the main image we are going to use
-    cv::Mat outer = cv::Mat(sudoku.size(), CV_8UC1);
-    // declare the 2d vectors we are going to use for the corners of the board
-    cv::Vec2f topEdge, bottomEdge, leftEdge, rightEdge;
-    // preprocess/pretiffy our image
-    preprocessing(sudoku, outer);
-    // find the biggest blob
-    biggestBlob(outer);
-    // find the lines of the board
-    // Vectors in C++ are the equivilant of Arraylists in Java
-    std::vector<cv::Vec2f> lines = findLines(outer, topEdge, bottomEdge, leftEdge, rightEdge);
-    
-    // if there aren't enough lines then return false
-    if (lines.size()<8)
-        return false;
-
-    // set the image to the undistorted cropped image of the board
-    sudoku = undistortImage(sudoku, topEdge, bottomEdge, leftEdge, rightEdge);
-    // got the board
-    return true;
-}
-
 // get the board input from the video camera
 cv::Mat getInput(cv::VideoCapture* cap){
     // if the camera is not open then leave
@@ -45,21 +20,22 @@ cv::Mat getInput(cv::VideoCapture* cap){
         exit(1);
     
     // declare our images
-    cv::Mat frame, img;
+    cv::Mat frame, img, board, binary;
+    // the warp tables are kept between frames so a still board isn't rewarped from scratch
+    sudokuocr::Tracker tracker;
     // if we have a valid board from the frame
     bool gotBoard;
     // infinite loop
     for (;;){
         // read the current frame
         cap->read(frame);
-        // clone it(objects are pass by reference so we need to clone to avoid both images being changed);
-        img = frame.clone();
         // convert the image to the correct number of image streams and inputs
-        convertToCV8UC1(img);
+        // a new image is made so the frame shown below stays in color
+        sudokuocr::toGray(frame, img);
         // try to get the board
-        gotBoard = getSudokuGrid(img);
+        gotBoard = sudokuocr::detectGrid(img, board, binary, tracker);
         if (gotBoard)
-            cv::imshow("Board", img);
+            cv::imshow("Board", board);
         else
             // get rid of the window from last time
             cv::destroyWindow("Board");
@@ -74,9 +50,9 @@ cv::Mat getInput(cv::VideoCapture* cap){
     }
     // get rid of all the windows
     cv::destroyAllWindows();
-    // clean up and return the image
+    // clean up and return the board
     delete cap;
-    return img;
+    return board;
 }
 
 // get the input from a local photo
@@ -85,13 +61,85 @@ cv::Mat getInput(std::string path){
     return cv::imread(path, CV_8UC1);
 }
 
+// print a board as 9 rows of numbers with . for an empty cell
+void printBoard(int board[9][9]){
+    for (int row = 0; row<9; row++){
+        for (int col = 0; col<9; col++)
+            std::cout<<(board[row][col] ? (char)('0'+board[row][col]) : '.')<<(col==8 ? "" : " ");
+        std::cout<<std::endl;
+    }
+}
+
+// find, read and solve every board on a page and print them instead of using the game
+int solvePage(std::string path){
+    cv::Mat page = getInput(path);
+    if (page.empty()){
+        std::cerr<<"Couldn't read "<<path<<std::endl;
+        return 1;
+    }
+    // an ocr for every core so the boards are read in parallel
+    sudokuocr::OCRPool pool(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<sudokuocr::Board> boards;
+    if (!sudokuocr::solvePage(page, boards, pool)){
+        std::cerr<<"Couldn't load the tesseract language data"<<std::endl;
+        return 1;
+    }
+
+    std::cout<<"found "<<boards.size()<<" boards"<<std::endl;
+    for (size_t counter = 0; counter<boards.size(); counter++){
+        cv::Rect area = boards[counter].area;
+        std::cout<<std::endl<<"board "<<counter+1<<" at "<<area.x<<","<<area.y<<" ("<<area.width<<"x"<<area.height<<")"<<std::endl;
+        printBoard(boards[counter].grid);
+        if (boards[counter].solved){
+            std::cout<<"solution"<<std::endl;
+            printBoard(boards[counter].solution);
+        }
+        else
+            std::cout<<"no solution"<<std::endl;
+    }
+    return 0;
+}
+
+// find every distinct board in a video file and print them with the frame they first appeared in
+int solveVideo(std::string path){
+    BasicOCR ocr;
+    if (!ocr.ok()){
+        std::cerr<<"Couldn't load the tesseract language data"<<std::endl;
+        return 1;
+    }
+    sudokuocr::VideoScan scan;
+    if (!sudokuocr::scanVideo(path, ocr, scan)){
+        std::cerr<<"Couldn't open "<<path<<std::endl;
+        return 1;
+    }
+
+    std::cout<<"read "<<scan.frames<<" frames, looked for boards in "<<scan.processed<<", found "<<scan.boards.size()<<" distinct boards"<<std::endl;
+    for (size_t counter = 0; counter<scan.boards.size(); counter++){
+        std::cout<<std::endl<<"board "<<counter+1<<" at frame "<<scan.boards[counter].frame<<std::endl;
+        printBoard(scan.boards[counter].grid);
+    }
+    return 0;
+}
 
 // C++ allows for command line arguments stored in argv which we can use later in the program
 int main(int argc, char ** argv){
+    // a page with several boards is solved without the game
+    if (argc>2 && !strcmp(argv[1], "--page"))
+        return solvePage(argv[2]);
+    // so is a video file with boards in it
+    if (argc>2 && !strcmp(argv[1], "--video"))
+        return solveVideo(argv[2]);
+
     // create all of our objects we need
     // The new keyword in C++ returns a pointer to an object
     SudokuGame* game = new SudokuGame();
     BasicOCR* ocr = new BasicOCR();
+    if (!ocr->ok()){
+        std::cerr<<"Couldn't load the tesseract language data"<<std::endl;
+        delete game;
+        delete ocr;
+        return 1;
+    }
     //cv::VideoCapture* cap = new cv::VideoCapture(0);
     // check if we have valid input
     //if (argc<2){
@@ -101,41 +149,20 @@ int main(int argc, char ** argv){
     // get our input
     cv::Mat img = getInput("test.jpg");
     
-    // get the board
-    getSudokuGrid(img);
-    // threshold so we are in black and white
-    cv::Mat undistortedAdjusted = img.clone();
-    cv::adaptiveThreshold(img, undistortedAdjusted, 255, CV_ADAPTIVE_THRESH_GAUSSIAN_C, CV_THRESH_BINARY_INV, 101, 1);
-    // get the cell size
-    int cellSize = ceil((double)(img.size().width/9));
-    // declare and define the current cell image variable
-    cv::Mat currentCell = cv::Mat(cellSize, cellSize, CV_8UC1);
-
-    // for each cell in the board
-    for (int counter = 0; counter<9; counter++){
-        for (int counter2 = 0; counter2<9; counter2++){
-            
-            // copy from undistortedAdjusted to the current cell value
-            for (int y = 0; y<cellSize && counter*cellSize+y<undistortedAdjusted.rows; y++)
-                for (int x = 0; x<cellSize && counter2*cellSize+x<undistortedAdjusted.cols; x++)    
-                    currentCell.ptr(y)[x] = undistortedAdjusted.at<uchar>(counter*cellSize+y, counter2*cellSize+x);
-            
-            // moments are used to check distribution and a bunch of other seriously advanced math
-            // I just use them to check if I have an empty image
-            cv::Moments moment = cv::moments(currentCell, true);
-            cv::Rect rect;
-            // if the distribution is greater than 1/5 of the total area then it is an actual number we need to determine
-            if (moment.m00>currentCell.rows*currentCell.cols/5 && (rect = contour(currentCell.clone(), cellSize)).area()!=1 ){
-                // crop any excess board lines we don't need by contouring the image to find the central focus a.k.a the number
-                cv::Mat next = currentCell(rect);
-                // classify and read the number into the game object's board array
-                (*game)(counter,counter2) = ocr->classify(next);
-            }
-            // if no number is found then set the value to nothing
-            else
-                (*game)(counter,counter2) = 0;
-        }
-    }
+    // get the board warped to the canonical size and the black and white version of it
+    cv::Mat board, undistortedAdjusted;
+    sudokuocr::Tracker tracker;
+    // if no board was found then threshold the whole image like before
+    if (!sudokuocr::detectGrid(img, board, undistortedAdjusted, tracker))
+        cv::adaptiveThreshold(img, undistortedAdjusted, 255, CV_ADAPTIVE_THRESH_GAUSSIAN_C, CV_THRESH_BINARY_INV, 101, 1);
+    // cut out and read the numbers in the cells into the game object's board array
+    std::vector<cv::Mat> cells;
+    int grid[9][9];
+    sudokuocr::extractCells(undistortedAdjusted, cells);
+    sudokuocr::classifyCells(cells, *ocr, grid);
+    for (int counter = 0; counter<9; counter++)
+        for (int counter2 = 0; counter2<9; counter2++)
+            (*game)(counter,counter2) = grid[counter][counter2];
 
     // pass control to the sudoku game
     game->main();
@@ -0,0 +1,226 @@
+#include "pipeline.h"
+#include "sudokuocr.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+// get the milliseconds since tick and move tick up to now
+static double lap(int64& tick){
+    int64 now = cv::getTickCount();
+    double ms = (now-tick)*1000.0/cv::getTickFrequency();
+    tick = now;
+    return ms;
+}
+
+int countClues(const int grid[9][9]){
+    int clues = 0;
+    for (int cell = 0; cell<81; cell++)
+        if (grid[cell/9][cell%9]>0 && grid[cell/9][cell%9]<=9)
+            clues++;
+    return clues;
+}
+
+bool sameBoard(const int first[9][9], const int second[9][9]){
+    int shared = 0, different = 0;
+    for (int cell = 0; cell<81; cell++){
+        int a = first[cell/9][cell%9], b = second[cell/9][cell%9];
+        if (a<=0 || a>9 || b<=0 || b>9)
+            continue;
+        shared++;
+        if (a!=b)
+            different++;
+    }
+    // two different boards can happen to share only a few cells, so most of the smaller read has to be shared too
+    return different<=MAX_CELL_DIFF && shared*2>=std::min(countClues(first), countClues(second));
+}
+
+bool parseConfig(const std::string& options, PipelineConfig& config){
+    config = PipelineConfig();
+    std::stringstream stream(options);
+    std::string option;
+    // every option overrides the default of one setting
+    while (std::getline(stream, option, ',')){
+        if (option=="quad") config.quadFit = true;
+        else if (option=="hough") config.quadFit = false;
+        else if (option=="shared") config.sharedThreshold = true;
+        else if (option=="legacy") config.sharedThreshold = false;
+        else if (option=="fixed") config.fixedSize = true;
+        else if (option=="natural") config.fixedSize = false;
+        // a typo would otherwise quietly run the default for that setting
+        else return false;
+    }
+    return true;
+}
+
+std::string configName(const PipelineConfig& config){
+    return std::string(config.quadFit ? "quad" : "hough") + "," + (config.sharedThreshold ? "shared" : "legacy") + "," + (config.fixedSize ? "fixed" : "natural");
+}
+
+// find the corners of the board in the blob mask, fitting a quad first if the config allows and falling back to hough lines
+static bool findBoardCorners(cv::Mat& outer, cv::Mat gray, const PipelineConfig& config, cv::Point2f corners[4]){
+    // try to fit the outline of the board directly since it is faster and steadier between frames than hough lines
+    if (config.quadFit && findQuad(outer, gray, corners))
+        return true;
+
+    // declare the 2d vectors we are going to use for the corners of the board
+    cv::Vec2f topEdge, bottomEdge, leftEdge, rightEdge;
+    // find the lines of the board
+    // Vectors in C++ are the equivilant of Arraylists in Java
+    std::vector<cv::Vec2f> lines = findLines(outer, topEdge, bottomEdge, leftEdge, rightEdge);
+
+    // if there aren't enough lines then return false
+    if (lines.size()<8)
+        return false;
+    // get the corners where the edges meet
+    getBoardCorners(outer.size(), topEdge, bottomEdge, leftEdge, rightEdge, corners);
+    return true;
+}
+
+// warp the board out of the frame and threshold it the way the config says
+static void warpBoard(cv::Mat sudoku, const cv::Point2f corners[4], FrameCache& cache, WarpCache* warp, cv::Mat& board, cv::Mat* binary, const PipelineConfig& config, StageTimes* times, int64& tick){
+    // set the image to the undistorted cropped image of the board
+    WarpCache localWarp;
+    cv::Mat transform;
+    if (config.fixedSize){
+        // warp to the canonical size using the caller's tables if they keep them between frames
+        if (!warp) warp = &localWarp;
+        undistortImage(sudoku, corners, *warp, board);
+    }
+    else
+        board = undistortImage(sudoku, corners, &transform);
+    if (times) times->warp += lap(tick);
+
+    // threshold the board so we are in black and white
+    if (binary){
+        if (!config.sharedThreshold)
+            cv::adaptiveThreshold(board, *binary, 255, cv::ADAPTIVE_THRESH_GAUSSIAN_C, cv::THRESH_BINARY_INV, 101, 1);
+        // reuse the frame's local mean warped the same way as the board
+        else if (config.fixedSize)
+            thresholdUndistorted(cache, *warp, board, *binary);
+        else
+            thresholdUndistorted(cache, board, transform, *binary);
+        if (times) times->threshold += lap(tick);
+    }
+}
+
+// preprocess the frame into a black and white image of its lines the way the config says
+static void preprocessFrame(cv::Mat sudoku, FrameCache& cache, cv::Mat& outer, const PipelineConfig& config){
+    if (config.sharedThreshold){
+        // blur the frame and build its integral image once so both thresholds can use it
+        buildFrameCache(sudoku, cache);
+        preprocessing(cache, outer);
+    }
+    else
+        preprocessing(sudoku, outer);
+}
+
+bool getSudokuGrid(cv::Mat sudoku, cv::Mat& board, cv::Mat* binary, WarpCache* warp, const PipelineConfig& config, StageTimes* times){
+    // C++ has namespaces so you can have multiple functions with the same name but in different name spaces
+    // the double colon means a function or value in said namespace
+    int64 tick = cv::getTickCount();
+
+    // use the caller's buffers if it keeps them between frames so a frame the same size as the last allocates nothing
+    WarpCache localWarp;
+    if (!warp) warp = &localWarp;
+    FrameCache& cache = warp->frame;
+    // creates the main image we are going to use
+    cv::Mat& outer = warp->outer;
+    outer.create(sudoku.size(), CV_8UC1);
+    // preprocess/pretiffy our image
+    preprocessFrame(sudoku, cache, outer, config);
+    if (times) times->preprocess += lap(tick);
+
+    // find the biggest blob
+    biggestBlob(outer);
+    if (times) times->blob += lap(tick);
+
+    cv::Point2f corners[4];
+    bool found = findBoardCorners(outer, sudoku, config, corners);
+    if (times) times->corners += lap(tick);
+    if (!found)
+        return false;
+
+    warpBoard(sudoku, corners, cache, warp, board, binary, config, times, tick);
+    // got the board
+    return true;
+}
+
+int getSudokuGrids(cv::Mat page, std::vector<PageBoard>& boards, const PipelineConfig& config, int minSide){
+    // by default a board has to be at least a tenth of the page across
+    if (minSide<=0)
+        minSide = std::min(page.rows, page.cols)/10;
+
+    // preprocess the whole page once for every board on it
+    cv::Mat outer = cv::Mat(page.size(), CV_8UC1);
+    FrameCache cache;
+    preprocessFrame(page, cache, outer, config);
+
+    // find every grid shaped blob in one labeling pass
+    std::vector<cv::Rect> boxes;
+    std::vector<cv::Mat> masks;
+    findGridBlobs(outer, minSide, boxes, masks);
+
+    boards.clear();
+    for (size_t counter = 0; counter<boxes.size(); counter++){
+        // find the corners inside the blob's box and move them back to where they are on the page
+        cv::Point2f corners[4];
+        if (!findBoardCorners(masks[counter], page(boxes[counter]), config, corners))
+            continue;
+        for (int corner = 0; corner<4; corner++)
+            corners[corner] += cv::Point2f(boxes[counter].x, boxes[counter].y);
+
+        // warp each board out of the page on its own
+        PageBoard found;
+        found.area = boxes[counter];
+        int64 tick = cv::getTickCount();
+        warpBoard(page, corners, cache, nullptr, found.board, &found.binary, config, nullptr, tick);
+        // frames, boxed ads and tables can pass the blob's shape tests so make sure it has the lines of a grid inside
+        if (!hasGridLines(found.binary))
+            continue;
+        boards.push_back(found);
+    }
+    return boards.size();
+}
+
+bool readAndSolveBoards(std::vector<PageBoard>& boards, sudokuocr::OCRPool& pool){
+    if (!pool.ok())
+        return false;
+    if (boards.empty())
+        return true;
+    int threads = std::min(pool.size(), (int)boards.size());
+    std::vector<std::thread> workers;
+    // every thread reads its own share of the boards with its own ocr since tesseract can't be shared between threads
+    for (int thread = 0; thread<threads; thread++){
+        workers.push_back(std::thread([&boards, &pool, thread, threads](){
+            BasicOCR& ocr = pool[thread];
+            for (size_t counter = thread; counter<boards.size(); counter += threads){
+                PageBoard& board = boards[counter];
+                readCells(board.binary, ocr, board.grid);
+                memcpy(board.solution, board.grid, sizeof(board.solution));
+                // don't bother solving something with too few numbers to be a real board, it gets dropped below
+                board.solved = countClues(board.grid)>=MIN_CLUES && solveBoard(board.solution);
+            }
+        }));
+    }
+    for (size_t thread = 0; thread<workers.size(); thread++)
+        workers[thread].join();
+
+    // drop anything that had too few numbers read from it to be a real board
+    boards.erase(std::remove_if(boards.begin(), boards.end(), [](const PageBoard& board){
+        return countClues(board.grid)<MIN_CLUES;
+    }), boards.end());
+    return true;
+}
+
+void readCells(cv::Mat binary, BasicOCR& ocr, int grid[9][9], StageTimes* times){
+    int64 tick = cv::getTickCount();
+    // cut out the numbers in the cells
+    std::vector<cv::Mat> cells;
+    sudokuocr::extractCells(binary, cells);
+    if (times) times->cells += lap(tick);
+
+    // classify and read the numbers into the grid
+    sudokuocr::classifyCells(cells, ocr, grid);
+    if (times) times->ocr += lap(tick);
+}
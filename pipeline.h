@@ -0,0 +1,53 @@
+// the full image to numbers pipeline behind the API in sudokuocr.h, private to the library and its tools
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+#include <vector>
+#include "gridFinder.h"
+#include "BasicOCR.h"
+#include "sudokuocr.h"
+#include "sudokuSolver.h"
+
+// the fewest clues a puzzle with one solution can have, anything less read from a frame isn't a real board
+#define MIN_CLUES 17
+// how many of the cells filled in both reads of the same board from different frames can be read differently
+#define MAX_CELL_DIFF 3
+
+// the pipeline's settings and results are the ones the API gives out
+typedef sudokuocr::Options PipelineConfig;
+typedef sudokuocr::Board PageBoard;
+typedef sudokuocr::VideoBoard VideoBoard;
+typedef sudokuocr::VideoScan VideoScan;
+
+// how long each stage of the pipeline took in milliseconds, added to on every call
+struct StageTimes{
+    double preprocess = 0, blob = 0, corners = 0, warp = 0, threshold = 0, cells = 0, ocr = 0;
+};
+
+// count the numbers read into the grid
+int countClues(const int grid[9][9]);
+// check if two grids read from different frames are the same board
+// they are if the cells filled in both mostly overlap and at most MAX_CELL_DIFF of those cells were read differently
+bool sameBoard(const int first[9][9], const int second[9][9]);
+// reads a config from comma separated options(quad, hough, shared, legacy, fixed, natural)
+// returns false if there is an option it doesn't know
+bool parseConfig(const std::string& options, PipelineConfig& config);
+// turns a config back into its options
+std::string configName(const PipelineConfig& config);
+// gets the sudoku cropped image grid into board, and if binary is given also the black and white version of it
+// the frame buffers, and the warp tables if the config uses a fixed size, are kept in warp between calls
+bool getSudokuGrid(cv::Mat sudoku, cv::Mat& board, cv::Mat* binary = nullptr, WarpCache* warp = nullptr, const PipelineConfig& config = PipelineConfig(), StageTimes* times = nullptr);
+// finds every board with sides of at least minSide pixels(0 for a tenth of the page) and the inner lines of a grid
+// from one preprocessing pass and warps each into boards, returning how many were found
+int getSudokuGrids(cv::Mat page, std::vector<PageBoard>& boards, const PipelineConfig& config = PipelineConfig(), int minSide = 0);
+// reads the cells of every board and solves them split over a thread per ocr in the pool
+// boards with fewer than MIN_CLUES numbers read aren't real boards and are removed
+// returns false if the pool's language data couldn't be loaded
+bool readAndSolveBoards(std::vector<PageBoard>& boards, sudokuocr::OCRPool& pool);
+// reads the number in each cell of the black and white board, 0 for an empty cell
+void readCells(cv::Mat binary, BasicOCR& ocr, int grid[9][9], StageTimes* times = nullptr);
+
+#endif
@@ -0,0 +1,114 @@
+#include "puzzleGenerator.h"
+#include <algorithm>
+#include <thread>
+
+void generatePuzzle(Puzzle& puzzle, std::mt19937& rng, int targetClues){
+    // start from a random complete board
+    fillBoard(puzzle.solution, rng);
+    for (int index = 0; index<81; index++)
+        puzzle.board[index/9][index%9] = puzzle.solution[index/9][index%9];
+
+    // try to remove the cells in a random order
+    int order[81];
+    for (int index = 0; index<81; index++)
+        order[index] = index;
+    std::shuffle(order, order+81, rng);
+
+    int clues = 81;
+    for (int counter = 0; counter<81 && clues>targetClues; counter++){
+        int row = order[counter]/9, col = order[counter]%9;
+        puzzle.board[row][col] = 0;
+        // if removing the clue gives the board a second solution then put it back
+        if (countSolutions(puzzle.board, 2)!=1)
+            puzzle.board[row][col] = puzzle.solution[row][col];
+        else
+            clues--;
+    }
+    puzzle.difficulty = gradeBoard(puzzle.board);
+}
+
+std::mt19937 puzzleRng(unsigned int seed, int index, int stream){
+    std::seed_seq sequence = {seed, (unsigned int)index, (unsigned int)stream};
+    return std::mt19937(sequence);
+}
+
+std::vector<Puzzle> generatePuzzles(int count, unsigned int seed, int threads, int targetClues){
+    std::vector<Puzzle> puzzles(count);
+    threads = std::max(1, std::min(threads, count));
+    std::vector<std::thread> workers;
+    // every thread fills its own slice of the vector so nothing is shared
+    for (int thread = 0; thread<threads; thread++){
+        int start = (long long)count*thread/threads, end = (long long)count*(thread+1)/threads;
+        workers.push_back(std::thread([&puzzles, seed, start, end, targetClues](){
+            for (int index = start; index<end; index++){
+                // each puzzle gets a generator made from the seed and its index so the thread count doesn't change it
+                std::mt19937 rng = puzzleRng(seed, index);
+                generatePuzzle(puzzles[index], rng, targetClues);
+            }
+        }));
+    }
+    for (size_t thread = 0; thread<workers.size(); thread++)
+        workers[thread].join();
+    return puzzles;
+}
+
+cv::Mat renderPuzzle(const Puzzle& puzzle, std::mt19937& rng, bool distort){
+    // draw the board flat on white paper, 56 pixels a cell with a margin around it
+    const int cellSize = 56, margin = 40, side = cellSize*9 + margin*2;
+    cv::Mat flat(side, side, CV_8UC1, cv::Scalar(255));
+    for (int line = 0; line<=9; line++){
+        // the lines around the boxes are thicker
+        int thickness = line%3==0 ? 4 : 1;
+        int offset = margin + line*cellSize;
+        cv::line(flat, cv::Point(margin, offset), cv::Point(side-margin, offset), cv::Scalar(0), thickness);
+        cv::line(flat, cv::Point(offset, margin), cv::Point(offset, side-margin), cv::Scalar(0), thickness);
+    }
+
+    // draw the clues centered in their cells
+    for (int row = 0; row<9; row++)
+        for (int col = 0; col<9; col++){
+            if (puzzle.board[row][col]==0) continue;
+            std::string digit = std::to_string(puzzle.board[row][col]);
+            int baseline;
+            cv::Size text = cv::getTextSize(digit, cv::FONT_HERSHEY_SIMPLEX, 1.4, 3, &baseline);
+            cv::Point origin(margin + col*cellSize + (cellSize-text.width)/2, margin + row*cellSize + (cellSize+text.height)/2);
+            cv::putText(flat, digit, origin, cv::FONT_HERSHEY_SIMPLEX, 1.4, cv::Scalar(0), 3, cv::LINE_AA);
+        }
+
+    if (!distort)
+        return flat;
+
+    // move each corner of the page a random amount to fake the angle of a camera
+    std::uniform_real_distribution<float> jitter(-0.08f*side, 0.08f*side);
+    const int photoSide = side + side/2;
+    float inset = side/4.0f;
+    cv::Point2f srcGrid[4], destGrid[4];
+    srcGrid[0] = cv::Point2f(0, 0);
+    srcGrid[1] = cv::Point2f(side-1, 0);
+    srcGrid[2] = cv::Point2f(side-1, side-1);
+    srcGrid[3] = cv::Point2f(0, side-1);
+    for (int corner = 0; corner<4; corner++)
+        destGrid[corner] = srcGrid[corner] + cv::Point2f(inset + jitter(rng), inset + jitter(rng));
+
+    // the background behind the page is a darker gray
+    cv::Mat photo;
+    cv::warpPerspective(flat, photo, cv::getPerspectiveTransform(srcGrid, destGrid), cv::Size(photoSide, photoSide), cv::INTER_LINEAR, cv::BORDER_CONSTANT, cv::Scalar(90));
+
+    // slightly blur and add sensor noise like a real photo
+    cv::GaussianBlur(photo, photo, cv::Size(3,3), 0);
+    cv::Mat noise(photo.size(), CV_16SC1);
+    cv::RNG noiseRng(rng());
+    noiseRng.fill(noise, cv::RNG::NORMAL, 0, 12);
+    cv::Mat noisy;
+    photo.convertTo(noisy, CV_16SC1);
+    noisy += noise;
+    noisy.convertTo(photo, CV_8UC1);
+    return photo;
+}
+
+std::string boardToString(const int board[9][9]){
+    std::string text(81, '0');
+    for (int index = 0; index<81; index++)
+        text[index] = '0' + board[index/9][index%9];
+    return text;
+}
@@ -0,0 +1,35 @@
+// generates random puzzles with a single solution to load test the solver and the OCR pipeline
+#ifndef PUZZLE_GENERATOR_H
+#define PUZZLE_GENERATOR_H
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <random>
+#include <string>
+#include <vector>
+#include "sudokuSolver.h"
+
+// a generated puzzle along with its answer
+struct Puzzle{
+    // the clues, 0 for an empty cell
+    int board[9][9];
+    // the only solution of the board
+    int solution[9][9];
+    // how hard the puzzle is
+    Difficulty difficulty;
+};
+
+// generate one puzzle by filling a random board and removing clues while it still has one solution
+// stops removing once the board is down to targetClues clues(0 removes as many as possible)
+void generatePuzzle(Puzzle& puzzle, std::mt19937& rng, int targetClues = 0);
+// get the random generator for the puzzle at index, stream picks independent generators for the same puzzle(eg. for rendering)
+std::mt19937 puzzleRng(unsigned int seed, int index, int stream = 0);
+// generate count puzzles split over the given number of threads
+// puzzle i only depends on the seed and i, so the same seed gives the same puzzles whatever the thread count
+std::vector<Puzzle> generatePuzzles(int count, unsigned int seed, int threads, int targetClues = 0);
+// draw the puzzle like a photo of a printed board, with a random perspective distortion and noise if distort is true
+cv::Mat renderPuzzle(const Puzzle& puzzle, std::mt19937& rng, bool distort = true);
+// get the board as 81 characters, 0 for an empty cell
+std::string boardToString(const int board[9][9]);
+
+#endif
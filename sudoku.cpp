@@ -105,11 +105,11 @@ bool SudokuGame::solve(WINDOW* win, int cellSize, int row, int col){
         // set the board position to the value
         board[row][col] = possibleValue;
         // if we are animating then pause
-        if (ANIMATION){
+        if (animate){
             drawNumbers(win, cellSize, false);
             wrefresh(win);
             refresh();
-            std::this_thread::sleep_for(ANIMATION_WAIT);
+            std::this_thread::sleep_for(animationWait);
         }
         // attempt to solve from this point out using the current value
         if (solve(win, cellSize, row, col)) return true;
@@ -144,7 +144,7 @@ void SudokuGame::main(){
     // get the measurements for the board
     int maxX, maxY;
     getmaxyx(stdscr, maxY, maxX);
-    int gridSideLength = min(maxX, maxY);
+    int gridSideLength = std::min(maxX, maxY);
     gridSideLength-=gridSideLength%9;
     
     // create the window
@@ -8,13 +8,6 @@
 #include <chrono>
 #include <thread>
 
-// min function macro
-#define min(a,b) (((a)<(b))? a:b)
-// time to sleep for the animation time 
-#define ANIMATION_WAIT std::chrono::milliseconds(15)
-// should the grid be animated
-#define ANIMATION true
-
 class SudokuGame{
     // public methods
     public:
@@ -27,6 +20,11 @@ class SudokuGame{
 
         // main function
         void main();
+
+        // should the grid be animated while solving
+        bool animate = true;
+        // time to sleep for between animation frames
+        std::chrono::milliseconds animationWait = std::chrono::milliseconds(15);
     
     private:
         // solve the board
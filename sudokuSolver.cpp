@@ -0,0 +1,206 @@
+#include "sudokuSolver.h"
+#include <algorithm>
+
+// a bit for every digit from 1 to 9
+#define ALL_DIGITS 0x1FF
+
+// the board while it is being solved, every row, column and box keeps a bit for each digit it already has
+// so the possible values for a cell can be found with a couple of bitwise operations instead of scanning the board
+struct SolverState{
+    int cells[81];
+    int rows[9], cols[9], boxes[9];
+};
+
+// get the box a cell is in
+static int boxOf(int index){
+    return (index/27)*3 + (index%9)/3;
+}
+
+// get the bits of every value that can go in a cell
+static int candidates(SolverState& state, int index){
+    return ALL_DIGITS & ~(state.rows[index/9] | state.cols[index%9] | state.boxes[boxOf(index)]);
+}
+
+// put a digit in a cell
+static void place(SolverState& state, int index, int digit){
+    int bit = 1<<(digit-1);
+    state.cells[index] = digit;
+    state.rows[index/9] |= bit;
+    state.cols[index%9] |= bit;
+    state.boxes[boxOf(index)] |= bit;
+}
+
+// take a digit back out of a cell
+static void unplace(SolverState& state, int index, int digit){
+    int bit = ~(1<<(digit-1));
+    state.cells[index] = 0;
+    state.rows[index/9] &= bit;
+    state.cols[index%9] &= bit;
+    state.boxes[boxOf(index)] &= bit;
+}
+
+// load a board into the state, returns false if the given values already break the sudoku rules
+static bool load(SolverState& state, int board[9][9]){
+    std::fill(state.rows, state.rows+9, 0);
+    std::fill(state.cols, state.cols+9, 0);
+    std::fill(state.boxes, state.boxes+9, 0);
+    for (int index = 0; index<81; index++){
+        int digit = board[index/9][index%9];
+        state.cells[index] = 0;
+        if (digit==0) continue;
+        // the digit has to be valid and not already be in the row, column or box
+        if (digit<0 || digit>9 || !(candidates(state, index) & (1<<(digit-1))))
+            return false;
+        place(state, index, digit);
+    }
+    return true;
+}
+
+// copy the state back into a board
+static void store(SolverState& state, int board[9][9]){
+    for (int index = 0; index<81; index++)
+        board[index/9][index%9] = state.cells[index];
+}
+
+// recursive search that always tries the cell with the fewest possible values first
+// returns true once limit solutions have been found, leaving the last solution in the state
+static bool search(SolverState& state, int& found, int limit, std::mt19937* rng){
+    // find the empty cell with the fewest possible values
+    int best = -1, bestCount = 10, bestMask = 0;
+    for (int index = 0; index<81; index++){
+        if (state.cells[index]) continue;
+        int mask = candidates(state, index);
+        int count = __builtin_popcount(mask);
+        if (count<bestCount){
+            best = index;
+            bestCount = count;
+            bestMask = mask;
+            // can't do better than a cell with one(or no) possible values
+            if (count<=1) break;
+        }
+    }
+    // if there are no empty cells then we found a solution
+    if (best==-1)
+        return ++found>=limit;
+    // if a cell has no possible values then this branch is a dead end
+    if (bestCount==0)
+        return false;
+
+    int digits[9], total = 0;
+    for (int digit = 1; digit<=9; digit++)
+        if (bestMask & (1<<(digit-1)))
+            digits[total++] = digit;
+    // try the values in a random order when filling a random board
+    if (rng)
+        std::shuffle(digits, digits+total, *rng);
+
+    for (int counter = 0; counter<total; counter++){
+        place(state, best, digits[counter]);
+        if (search(state, found, limit, rng)) return true;
+        unplace(state, best, digits[counter]);
+    }
+    return false;
+}
+
+bool solveBoard(int board[9][9]){
+    SolverState state;
+    int found = 0;
+    if (!load(state, board) || !search(state, found, 1, nullptr))
+        return false;
+    store(state, board);
+    return true;
+}
+
+int countSolutions(int board[9][9], int limit){
+    SolverState state;
+    int found = 0;
+    if (!load(state, board))
+        return 0;
+    search(state, found, limit, nullptr);
+    return found;
+}
+
+void fillBoard(int board[9][9], std::mt19937& rng){
+    SolverState state;
+    int found = 0;
+    std::fill(state.cells, state.cells+81, 0);
+    std::fill(state.rows, state.rows+9, 0);
+    std::fill(state.cols, state.cols+9, 0);
+    std::fill(state.boxes, state.boxes+9, 0);
+    // an empty board always has a solution so the search always succeeds
+    search(state, found, 1, &rng);
+    store(state, board);
+}
+
+// get the index of the k'th cell of a unit(0-8 are rows, 9-17 are columns and 18-26 are boxes)
+static int unitCell(int unit, int k){
+    if (unit<9) return unit*9 + k;
+    if (unit<18) return k*9 + (unit-9);
+    int box = unit-18;
+    return ((box/3)*3 + k/3)*9 + (box%3)*3 + k%3;
+}
+
+Difficulty gradeBoard(int board[9][9]){
+    SolverState state;
+    if (!load(state, board))
+        return UNSOLVABLE;
+
+    Difficulty difficulty = EASY;
+    for (;;){
+        bool progress = false, solved = true;
+        // fill in every cell that only has one possible value(naked singles)
+        for (int index = 0; index<81; index++){
+            if (state.cells[index]) continue;
+            solved = false;
+            int mask = candidates(state, index);
+            if (mask==0)
+                return UNSOLVABLE;
+            if (__builtin_popcount(mask)==1){
+                place(state, index, __builtin_ctz(mask)+1);
+                progress = true;
+            }
+        }
+        if (solved)
+            return difficulty;
+        if (progress)
+            continue;
+
+        // fill in every value that only fits in one cell of a row, column or box(hidden singles)
+        for (int unit = 0; unit<27; unit++){
+            for (int digit = 1; digit<=9; digit++){
+                int bit = 1<<(digit-1), count = 0, last = -1;
+                for (int k = 0; k<9 && count<2; k++){
+                    int index = unitCell(unit, k);
+                    // the digit is already in the unit so there is nothing to fill
+                    if (state.cells[index]==digit){
+                        count = 2;
+                    }
+                    else if (!state.cells[index] && (candidates(state, index) & bit)){
+                        count++;
+                        last = index;
+                    }
+                }
+                if (count==1){
+                    place(state, last, digit);
+                    progress = true;
+                }
+            }
+        }
+        if (progress){
+            difficulty = MEDIUM;
+            continue;
+        }
+
+        // singles aren't enough so the values have to be guessed, as long as there is a solution to guess towards
+        return countSolutions(board, 1) ? HARD : UNSOLVABLE;
+    }
+}
+
+const char* difficultyName(Difficulty difficulty){
+    switch (difficulty){
+        case EASY: return "easy";
+        case MEDIUM: return "medium";
+        case HARD: return "hard";
+        default: return "unsolvable";
+    }
+}
@@ -0,0 +1,30 @@
+// fast solver that works on plain boards without drawing anything so it can be used for generating and benchmarking
+#ifndef SUDOKU_SOLVER_H
+#define SUDOKU_SOLVER_H
+
+#include <random>
+
+// how hard a puzzle is, judged by the hardest technique needed to solve it
+enum Difficulty{
+    // only cells with a single possible value(naked singles) are needed
+    EASY,
+    // values that only fit in one cell of a row, column or box(hidden singles) are needed
+    MEDIUM,
+    // singles aren't enough and values have to be guessed
+    HARD,
+    // the board has no solution
+    UNSOLVABLE
+};
+
+// solve the board in place, returns false if the board can't be solved
+bool solveBoard(int board[9][9]);
+// count the solutions of the board, stopping once limit solutions are found
+int countSolutions(int board[9][9], int limit);
+// fill an empty board with a random complete solution
+void fillBoard(int board[9][9], std::mt19937& rng);
+// grade the board by the techniques needed to solve it
+Difficulty gradeBoard(int board[9][9]);
+// get the name of a difficulty for printing
+const char* difficultyName(Difficulty difficulty);
+
+#endif
@@ -0,0 +1,149 @@
+#include "sudokuocr.h"
+#include "pipeline.h"
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace sudokuocr{
+
+Tracker::Tracker() : warp(new WarpCache()){
+}
+
+// WarpCache is only complete in here so the destructor has to be too
+Tracker::~Tracker(){
+}
+
+OCRPool::OCRPool(int size, const std::string& dataPath) : ocrs(std::max(1, size)){
+    // loading the language data is slow so every ocr loads on its own thread
+    std::vector<std::thread> loaders;
+    for (size_t counter = 0; counter<ocrs.size(); counter++)
+        loaders.push_back(std::thread([this, counter, &dataPath](){
+            ocrs[counter].reset(new BasicOCR(dataPath));
+        }));
+    for (size_t counter = 0; counter<loaders.size(); counter++)
+        loaders[counter].join();
+}
+
+bool OCRPool::ok() const{
+    for (size_t counter = 0; counter<ocrs.size(); counter++)
+        if (!ocrs[counter]->ok())
+            return false;
+    return true;
+}
+
+int OCRPool::size() const{
+    return ocrs.size();
+}
+
+BasicOCR& OCRPool::operator[](int index){
+    return *ocrs[index];
+}
+
+void toGray(cv::Mat frame, cv::Mat& gray){
+    if (frame.channels()==3)
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    else if (frame.channels()==4)
+        cv::cvtColor(frame, gray, cv::COLOR_BGRA2GRAY);
+    else
+        gray = frame;
+}
+
+bool detectGrid(cv::Mat gray, cv::Mat& board, cv::Mat& binary, Tracker& tracker, const Options& options){
+    return getSudokuGrid(gray, board, &binary, tracker.warp.get(), options);
+}
+
+void extractCells(cv::Mat binary, std::vector<cv::Mat>& cells){
+    // every cell is left empty if there is no board
+    cells.assign(81, cv::Mat());
+    if (binary.empty())
+        return;
+    // get the cell size from the shorter side so the cells never go past the edge of a board that isn't square
+    int cellSize = std::min(binary.rows, binary.cols)/9;
+    if (cellSize==0)
+        return;
+
+    // for each cell in the board
+    for (int counter = 0; counter<9; counter++){
+        for (int counter2 = 0; counter2<9; counter2++){
+            // look at the cell in place rather than copying it out
+            cv::Mat currentCell = binary(cv::Rect(counter2*cellSize, counter*cellSize, cellSize, cellSize));
+
+            // moments are used to check distribution and a bunch of other seriously advanced math
+            // I just use them to check if I have an empty image
+            cv::Moments moment = cv::moments(currentCell, true);
+            cv::Rect rect;
+            // if the distribution is greater than 1/5 of the total area then it is an actual number we need to determine
+            if (moment.m00>currentCell.rows*currentCell.cols/5 && (rect = contour(currentCell.clone(), cellSize)).area()!=1 )
+                // crop any excess board lines we don't need by contouring the image to find the central focus a.k.a the number
+                cells[counter*9+counter2] = currentCell(rect);
+            // if no number is found then leave the cell empty
+            else
+                cells[counter*9+counter2] = cv::Mat();
+        }
+    }
+}
+
+void classifyCells(const std::vector<cv::Mat>& cells, BasicOCR& ocr, int grid[9][9]){
+    for (int cell = 0; cell<81; cell++)
+        grid[cell/9][cell%9] = (cell<(int)cells.size() && !cells[cell].empty()) ? ocr.classify(cells[cell]) : 0;
+}
+
+bool solve(int board[9][9]){
+    return solveBoard(board);
+}
+
+bool solvePage(cv::Mat page, std::vector<Board>& boards, OCRPool& pool, const Options& options){
+    boards.clear();
+    if (!pool.ok())
+        return false;
+    getSudokuGrids(page, boards, options);
+    return readAndSolveBoards(boards, pool);
+}
+
+bool scanVideo(const std::string& path, BasicOCR& ocr, VideoScan& scan, int maxDistance, const Options& options){
+    cv::VideoCapture capture(path);
+    if (!capture.isOpened())
+        return false;
+
+    cv::Mat frame, gray, board, binary;
+    // the frame buffers and warp tables are kept between frames so a still board isn't rewarped from scratch
+    WarpCache warp;
+    uint64_t lastHash = 0;
+    for (int index = 0; capture.read(frame); index++){
+        scan.frames++;
+        // skip frames that look the same as the last frame we looked at
+        uint64_t hash = frameHash(frame);
+        if (scan.processed>0 && hashDistance(hash, lastHash)<=maxDistance)
+            continue;
+        lastHash = hash;
+        scan.processed++;
+
+        // look for a board in the frame
+        toGray(frame, gray);
+        if (!getSudokuGrid(gray, board, &binary, &warp, options))
+            continue;
+
+        VideoBoard found;
+        found.frame = index;
+        readCells(binary, ocr, found.grid);
+        // only keep it if enough numbers were read for it to be a real board
+        int clues = countClues(found.grid);
+        if (clues<MIN_CLUES)
+            continue;
+
+        // the same board read from another frame can have a few cells misread or missed
+        // so if it matches a board we already have keep whichever read has more numbers
+        size_t match = 0;
+        while (match<scan.boards.size() && !sameBoard(scan.boards[match].grid, found.grid))
+            match++;
+        if (match==scan.boards.size())
+            scan.boards.push_back(found);
+        else if (clues>countClues(scan.boards[match].grid))
+            // keep the frame the board first appeared in
+            memcpy(scan.boards[match].grid, found.grid, sizeof(found.grid));
+    }
+    return true;
+}
+
+}